@@ -1,4 +1,6 @@
 #include <GL/glut.h>
+#include <GL/freeglut_ext.h>
+#include <GL/glext.h>
 #include <iostream>
 #include <vector>
 #include <cmath>
@@ -6,6 +8,7 @@
 #include <sstream>
 #include <fstream>
 #include <algorithm>
+#include <cstddef>
 
 using namespace std;
 
@@ -27,22 +30,90 @@ struct Figure {
     int thickness;
 };
 
+struct Rect {
+    int minX, minY, maxX, maxY;
+    Rect(int minX = 0, int minY = 0, int maxX = -1, int maxY = -1)
+        : minX(minX), minY(minY), maxX(maxX), maxY(maxY) {}
+    bool empty() const { return maxX < minX || maxY < minY; }
+    bool contains(Point p) const { return p.x >= minX && p.x <= maxX && p.y >= minY && p.y <= maxY; }
+    bool containsRect(const Rect& o) const {
+        return o.minX >= minX && o.maxX <= maxX && o.minY >= minY && o.maxY <= maxY;
+    }
+    bool intersects(const Rect& o) const {
+        return !empty() && !o.empty() && o.minX <= maxX && o.maxX >= minX && o.minY <= maxY && o.maxY >= minY;
+    }
+    Rect unite(const Rect& o) const {
+        if (empty()) return o;
+        if (o.empty()) return *this;
+        return Rect(min(minX, o.minX), min(minY, o.minY), max(maxX, o.maxX), max(maxY, o.maxY));
+    }
+};
+
+// Transformacin afn: x' = a*x + b*y + tx, y' = c*x + d*y + ty
+struct Affine {
+    float a = 1.0f, b = 0.0f, tx = 0.0f;
+    float c = 0.0f, d = 1.0f, ty = 0.0f;
+};
+
+// Registro por instancia para el modo GPU: una figura = una instancia
+struct FigureInstance {
+    float type;
+    float p0[2];
+    float p1[2];
+    float color[3];
+    float thickness;
+};
+
+// Capa con nombre: sus figuras y su rasterizado en cach (RGBA, transparente
+// donde no hay trazo), que solo se invalida cuando cambia la propia capa
+struct Layer {
+    string name;
+    vector<Figure> figures;
+    vector<Figure> redoStack;   // deshacer/rehacer es propio de cada capa
+    bool visible = true;
+    vector<unsigned char> cache;
+    bool cacheValid = false;
+    vector<Rect> dirtyRegions;
+    GLuint instanceBuffer = 0;  // modo GPU
+    GLsizei instanceCount = 0;
+    GLsizei instanceCapacity = 0;
+    bool instancesDirty = true;    // subir todas las instancias
+    vector<int> dirtyInstances;    // o solo estas figuras
+};
+
 // Variables globales
 const int WINDOW_WIDTH = 800;
 const int WINDOW_HEIGHT = 600;
 const int GRID_SIZE = 20;
+const int TILE_SIZE = 32; // las regiones sucias se agrupan en baldosas de la ventana
+const int TILES_X = (WINDOW_WIDTH + TILE_SIZE - 1) / TILE_SIZE;
+const int TILES_Y = (WINDOW_HEIGHT + TILE_SIZE - 1) / TILE_SIZE;
 
-vector<Figure> figures;
-vector<Figure> redoStack;
+vector<Layer> layers;     // de abajo hacia arriba
+int currentLayer = 0;
 vector<Point> currentPoints;
 Color currentColor(0.0f, 0.0f, 0.0f);
 int currentThickness = 1;
-int currentTool = 0; // 0: lnea directa, 1: lnea DDA, 2: crculo incremental, 3: crculo punto medio, 4: elipse
+int currentTool = 0; // 0: lnea directa, 1: lnea DDA, 2: crculo incremental, 3: crculo punto medio, 4: elipse, 5: seleccin
 bool showGrid = true;
 bool showAxes = true;
 bool showCoords = false;
 bool drawing = false;
 bool needsRedisplay = false;
+bool useGPU = false;        // false: algoritmos de CPU (referencia), true: instanciado por GPU
+bool gpuAvailable = false;
+bool destinationAlpha = true;     // el framebuffer guarda alfa para las cachs de capa
+vector<unsigned char> coverageScratch;
+
+// Seleccin (dentro de la capa actual)
+vector<int> selection;            // ndices en layers[currentLayer].figures
+vector<char> floatingFigures;     // figuras arrastradas, fuera de la cach
+bool movingSelection = false;
+bool boxSelecting = false;
+Point dragStart;
+Point dragCurrent;
+vector<float> selX, selY;         // puntos de la seleccin al iniciar la transformacin
+vector<float> outX, outY;
 
 // Prototipos de funciones
 void drawPixel(int x, int y, Color color, int thickness = 1);
@@ -55,6 +126,12 @@ void drawGrid();
 void drawAxes();
 void displayCoordinates(int x, int y);
 void exportToPPM(const string& filename);
+void drawFigureCPU(const Figure& figure);
+void drawFiguresCPU();
+bool initGPURenderer();
+void drawFiguresGPU();
+void compareRenderers();
+void clearSelection();
 
 // Implementacin de algoritmos de rasterizacin
 void drawPixel(int x, int y, Color color, int thickness) {
@@ -291,52 +368,1136 @@ void exportToPPM(const string& filename) {
     cout << "Imagen exportada como: " << filename << endl;
 }
 
-// Callbacks de OpenGL/GLUT
-void display() {
+void drawFigureCPU(const Figure& figure) {
+    switch (figure.type) {
+        case 0: // Lnea directa
+            if (figure.points.size() >= 2)
+                drawLineDirect(figure.points[0], figure.points[1], figure.color, figure.thickness);
+            break;
+        case 1: // Lnea DDA
+            if (figure.points.size() >= 2)
+                drawLineDDA(figure.points[0], figure.points[1], figure.color, figure.thickness);
+            break;
+        case 2: // Crculo incremental
+            if (figure.points.size() >= 2) {
+                int radius = static_cast<int>(sqrt(
+                    pow(figure.points[1].x - figure.points[0].x, 2) +
+                    pow(figure.points[1].y - figure.points[0].y, 2)
+                ));
+                drawCircleIncremental(figure.points[0], radius, figure.color, figure.thickness);
+            }
+            break;
+        case 3: // Crculo punto medio
+            if (figure.points.size() >= 2) {
+                int radius = static_cast<int>(sqrt(
+                    pow(figure.points[1].x - figure.points[0].x, 2) +
+                    pow(figure.points[1].y - figure.points[0].y, 2)
+                ));
+                drawCircleMidpoint(figure.points[0], radius, figure.color, figure.thickness);
+            }
+            break;
+        case 4: // Elipse
+            if (figure.points.size() >= 2) {
+                int rx = abs(figure.points[1].x - figure.points[0].x);
+                int ry = abs(figure.points[1].y - figure.points[0].y);
+                drawEllipseMidpoint(figure.points[0], rx, ry, figure.color, figure.thickness);
+            }
+            break;
+    }
+}
+
+void drawFiguresCPU() {
+    for (const auto& layer : layers) {
+        if (!layer.visible) continue;
+        for (const auto& figure : layer.figures) {
+            drawFigureCPU(figure);
+        }
+    }
+}
+
+// Renderizado por GPU: cada figura es una instancia de un quad que cubre su
+// caja envolvente; el fragment shader repite las muestras redondeadas de cada
+// algoritmo y descarta los pxeles que ningn punto de glPointSize cubre.
+const char* figureVertexShader =
+    "#version 130\n"
+    "in vec2 aCorner;\n"
+    "in float aType;\n"
+    "in vec2 aP0;\n"
+    "in vec2 aP1;\n"
+    "in vec3 aColor;\n"
+    "in float aThickness;\n"
+    "flat out float vType;\n"
+    "flat out vec2 vP0;\n"
+    "flat out vec2 vP1;\n"
+    "flat out vec3 vColor;\n"
+    "flat out float vThickness;\n"
+    "out vec2 vWorld;\n"
+    "void main() {\n"
+    "    vec2 lo;\n"
+    "    vec2 hi;\n"
+    "    if (aType < 1.5) {\n"
+    "        lo = min(aP0, aP1);\n"
+    "        hi = max(aP0, aP1);\n"
+    "    } else if (aType < 3.5) {\n"
+    "        float r = floor(length(aP1 - aP0));\n"
+    "        lo = aP0 - vec2(r);\n"
+    "        hi = aP0 + vec2(r);\n"
+    "    } else {\n"
+    "        vec2 r = abs(aP1 - aP0);\n"
+    "        lo = aP0 - r;\n"
+    "        hi = aP0 + r;\n"
+    "    }\n"
+    "    float pad = aThickness + 2.0;\n"
+    "    vWorld = mix(lo - vec2(pad), hi + vec2(pad), aCorner);\n"
+    "    vType = aType;\n"
+    "    vP0 = aP0;\n"
+    "    vP1 = aP1;\n"
+    "    vColor = aColor;\n"
+    "    vThickness = aThickness;\n"
+    "    gl_Position = gl_ModelViewProjectionMatrix * vec4(vWorld, 0.0, 1.0);\n"
+    "}\n";
+
+const char* figureFragmentShader =
+    "#version 130\n"
+    "flat in float vType;\n"
+    "flat in vec2 vP0;\n"
+    "flat in vec2 vP1;\n"
+    "flat in vec3 vColor;\n"
+    "flat in float vThickness;\n"
+    "in vec2 vWorld;\n"
+    "ivec2 k;\n"
+    "int lo;\n"
+    "int hi;\n"
+    "// glPointSize(t) en glVertex2i(c) pinta los pxeles c + [lo, hi] en cada eje\n"
+    "bool stamped(ivec2 c) {\n"
+    "    ivec2 o = k - c;\n"
+    "    return o.x >= lo && o.x <= hi && o.y >= lo && o.y <= hi;\n"
+    "}\n"
+    "// round() de C++: los medios se alejan de cero\n"
+    "float roundAway(float v) {\n"
+    "    return sign(v) * floor(abs(v) + 0.5);\n"
+    "}\n"
+    "// Muestras de drawLineDirect/drawLineDDA cuya coordenada mayor cae a menos\n"
+    "// de medio punto del pxel\n"
+    "bool lineCovered(ivec2 p0, ivec2 p1, bool dda) {\n"
+    "    ivec2 d = p1 - p0;\n"
+    "    if (d == ivec2(0)) return stamped(p0);\n"
+    "    bool xMajor = d.x != 0 && abs(d.y) <= abs(d.x);\n"
+    "    float m = (d.x != 0) ? float(d.y) / float(d.x) : 0.0;\n"
+    "    float b = float(p0.y) - m * float(p0.x);\n"
+    "    vec2 inc = vec2(d) / float(max(abs(d.x), abs(d.y)));\n"
+    "    for (int j = lo; j <= hi; j++) {\n"
+    "        if (xMajor) {\n"
+    "            int x = k.x - j;\n"
+    "            if (x < min(p0.x, p1.x) || x > max(p0.x, p1.x)) continue;\n"
+    "            float y = dda ? float(p0.y) + float(abs(x - p0.x)) * inc.y : m * float(x) + b;\n"
+    "            if (stamped(ivec2(x, int(roundAway(y))))) return true;\n"
+    "        } else {\n"
+    "            int y = k.y - j;\n"
+    "            if (y < min(p0.y, p1.y) || y > max(p0.y, p1.y)) continue;\n"
+    "            float x = dda ? float(p0.x) + float(abs(y - p0.y)) * inc.x\n"
+    "                          : ((d.x == 0) ? float(p0.x) : (float(y) - b) / m);\n"
+    "            if (stamped(ivec2(int(roundAway(x)), y))) return true;\n"
+    "        }\n"
+    "    }\n"
+    "    return false;\n"
+    "}\n"
+    "// drawCircleIncremental: pasos de 1/r radianes truncando las coordenadas absolutas\n"
+    "bool circleIncrementalCovered(ivec2 c, int r) {\n"
+    "    if (r < 1) return stamped(c);\n"
+    "    float inc = 1.0 / float(r);\n"
+    "    int n = int(ceil(6.2831853 / inc));\n"
+    "    vec2 q = vec2(k - c);\n"
+    "    float theta = atan(q.y, q.x);\n"
+    "    if (theta < 0.0) theta += 6.2831853;\n"
+    "    int i0 = int(floor(theta / inc + 0.5));\n"
+    "    int w = hi - lo + 3;\n"
+    "    for (int i = i0 - w; i <= i0 + w; i++) {\n"
+    "        float a = float(((i % n) + n) % n) * inc;\n"
+    "        if (a >= 6.2831853) continue;\n"
+    "        if (stamped(ivec2(vec2(c) + float(r) * vec2(cos(a), sin(a))))) return true;\n"
+    "    }\n"
+    "    return false;\n"
+    "}\n"
+    "// drawCircleMidpoint: en el octante x <= y la muestra es (x, round(sqrt(r^2 - x^2)))\n"
+    "bool circleMidpointCovered(ivec2 c, int r) {\n"
+    "    ivec2 q = k - c;\n"
+    "    for (int j = lo; j <= hi; j++) {\n"
+    "        for (int axis = 0; axis < 2; axis++) {\n"
+    "            int u = (axis == 0) ? q.x - j : q.y - j;\n"
+    "            if (abs(u) > r) continue;\n"
+    "            int v = int(roundAway(sqrt(float(r * r - u * u))));\n"
+    "            if (abs(u) > v) continue;\n"
+    "            ivec2 s0 = (axis == 0) ? ivec2(u, v) : ivec2(v, u);\n"
+    "            ivec2 s1 = (axis == 0) ? ivec2(u, -v) : ivec2(-v, u);\n"
+    "            if (stamped(c + s0) || stamped(c + s1)) return true;\n"
+    "        }\n"
+    "    }\n"
+    "    return false;\n"
+    "}\n"
+    "float ellipseY(float x, float rx, float ry) {\n"
+    "    return roundAway(ry * sqrt(max(1.0 - x * x / (rx * rx), 0.0)));\n"
+    "}\n"
+    "// drawEllipseMidpoint: la regin 1 avanza en x desde x = 1 mientras la pendiente\n"
+    "// es menor que 1; la regin 2 baja en y desde la ltima fila hasta y = 0\n"
+    "bool ellipseCovered(ivec2 c, int rx, int ry) {\n"
+    "    float frx = float(rx);\n"
+    "    float fry = float(ry);\n"
+    "    float rx2 = frx * frx;\n"
+    "    float ry2 = fry * fry;\n"
+    "    int xs = int(rx2 / sqrt(rx2 + ry2));\n"
+    "    int x1 = 1;\n"
+    "    for (int x = max(xs - 2, 0); x <= xs + 2; x++)\n"
+    "        if (ry2 * float(x) < rx2 * ellipseY(float(x), frx, fry)) x1 = x + 1;\n"
+    "    int yLast = int(ellipseY(float(x1), frx, fry));\n"
+    "    ivec2 q = k - c;\n"
+    "    for (int j = lo; j <= hi; j++) {\n"
+    "        int x = q.x - j;\n"
+    "        if (abs(x) >= 1 && abs(x) <= x1) {\n"
+    "            int y = int(ellipseY(float(x), frx, fry));\n"
+    "            if (stamped(c + ivec2(x, y)) || stamped(c + ivec2(x, -y))) return true;\n"
+    "        }\n"
+    "        int y = q.y - j;\n"
+    "        if (abs(y) < yLast) {\n"
+    "            int xr = int(ellipseY(float(y), fry, frx));\n"
+    "            if (stamped(c + ivec2(xr, y)) || stamped(c + ivec2(-xr, y))) return true;\n"
+    "        }\n"
+    "    }\n"
+    "    return false;\n"
+    "}\n"
+    "void main() {\n"
+    "    k = ivec2(floor(vWorld));\n"
+    "    int t = int(max(vThickness, 1.0));\n"
+    "    lo = -(t / 2);\n"
+    "    hi = (t + 1) / 2 - 1;\n"
+    "    ivec2 p0 = ivec2(vP0);\n"
+    "    ivec2 p1 = ivec2(vP1);\n"
+    "    ivec2 d = p1 - p0;\n"
+    "    int r = int(sqrt(float(d.x * d.x + d.y * d.y)) + 1e-4);\n"
+    "    bool covered;\n"
+    "    if (vType < 0.5) covered = lineCovered(p0, p1, false);\n"
+    "    else if (vType < 1.5) covered = lineCovered(p0, p1, true);\n"
+    "    else if (vType < 2.5) covered = circleIncrementalCovered(p0, r);\n"
+    "    else if (vType < 3.5) covered = circleMidpointCovered(p0, r);\n"
+    "    else covered = d.x != 0 && d.y != 0 && ellipseCovered(p0, abs(d.x), abs(d.y));\n"
+    "    if (!covered) discard;\n"
+    "    gl_FragColor = vec4(vColor, 1.0);\n"
+    "}\n";
+
+enum { ATTR_CORNER = 0, ATTR_TYPE, ATTR_P0, ATTR_P1, ATTR_COLOR, ATTR_THICKNESS };
+
+PFNGLCREATESHADERPROC pglCreateShader;
+PFNGLSHADERSOURCEPROC pglShaderSource;
+PFNGLCOMPILESHADERPROC pglCompileShader;
+PFNGLGETSHADERIVPROC pglGetShaderiv;
+PFNGLGETSHADERINFOLOGPROC pglGetShaderInfoLog;
+PFNGLCREATEPROGRAMPROC pglCreateProgram;
+PFNGLATTACHSHADERPROC pglAttachShader;
+PFNGLBINDATTRIBLOCATIONPROC pglBindAttribLocation;
+PFNGLLINKPROGRAMPROC pglLinkProgram;
+PFNGLGETPROGRAMIVPROC pglGetProgramiv;
+PFNGLGETPROGRAMINFOLOGPROC pglGetProgramInfoLog;
+PFNGLUSEPROGRAMPROC pglUseProgram;
+PFNGLGENBUFFERSPROC pglGenBuffers;
+PFNGLBINDBUFFERPROC pglBindBuffer;
+PFNGLBUFFERDATAPROC pglBufferData;
+PFNGLBUFFERSUBDATAPROC pglBufferSubData;
+PFNGLDELETEBUFFERSPROC pglDeleteBuffers;
+PFNGLENABLEVERTEXATTRIBARRAYPROC pglEnableVertexAttribArray;
+PFNGLDISABLEVERTEXATTRIBARRAYPROC pglDisableVertexAttribArray;
+PFNGLVERTEXATTRIBPOINTERPROC pglVertexAttribPointer;
+PFNGLVERTEXATTRIBDIVISORPROC pglVertexAttribDivisor;
+PFNGLDRAWARRAYSINSTANCEDPROC pglDrawArraysInstanced;
+PFNGLDELETESHADERPROC pglDeleteShader;
+PFNGLDELETEPROGRAMPROC pglDeleteProgram;
+PFNGLGENFRAMEBUFFERSPROC pglGenFramebuffers;
+PFNGLBINDFRAMEBUFFERPROC pglBindFramebuffer;
+PFNGLDELETEFRAMEBUFFERSPROC pglDeleteFramebuffers;
+PFNGLCHECKFRAMEBUFFERSTATUSPROC pglCheckFramebufferStatus;
+PFNGLGENRENDERBUFFERSPROC pglGenRenderbuffers;
+PFNGLBINDRENDERBUFFERPROC pglBindRenderbuffer;
+PFNGLDELETERENDERBUFFERSPROC pglDeleteRenderbuffers;
+PFNGLRENDERBUFFERSTORAGEPROC pglRenderbufferStorage;
+PFNGLFRAMEBUFFERRENDERBUFFERPROC pglFramebufferRenderbuffer;
+
+GLuint figureProgram = 0;
+GLuint cornerBuffer = 0;
+vector<FigureInstance> instances;
+
+GLuint compileShader(GLenum type, const char* source) {
+    GLuint shader = pglCreateShader(type);
+    pglShaderSource(shader, 1, &source, nullptr);
+    pglCompileShader(shader);
+
+    GLint ok = GL_FALSE;
+    pglGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        pglGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        cerr << "Error al compilar el shader: " << log << endl;
+        pglDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+bool hasExtension(const string& name) {
+    const char* extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+    if (!extensions) return false;
+    string list = " " + string(extensions) + " ";
+    return list.find(" " + name + " ") != string::npos;
+}
+
+bool initGPURenderer() {
+    // glXGetProcAddress devuelve un puntero aunque la funcin no exista, as que
+    // la versin del contexto decide: GLSL 1.30 requiere 3.0 y el dibujo
+    // instanciado 3.3 o las extensiones ARB equivalentes
+    const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    int major = 0, minor = 0;
+    if (version) {
+        char dot;
+        istringstream vs(version);
+        vs >> major >> dot >> minor;
+    }
+    bool core33 = major > 3 || (major == 3 && minor >= 3);
+    bool arbInstancing = !core33 && major == 3 &&
+        hasExtension("GL_ARB_instanced_arrays") && hasExtension("GL_ARB_draw_instanced");
+    if (!core33 && !arbInstancing) {
+        cerr << "Error: OpenGL " << (version ? version : "?")
+             << " no soporta dibujo instanciado, se usar la CPU" << endl;
+        return false;
+    }
+
+    pglCreateShader = (PFNGLCREATESHADERPROC)glutGetProcAddress("glCreateShader");
+    pglShaderSource = (PFNGLSHADERSOURCEPROC)glutGetProcAddress("glShaderSource");
+    pglCompileShader = (PFNGLCOMPILESHADERPROC)glutGetProcAddress("glCompileShader");
+    pglGetShaderiv = (PFNGLGETSHADERIVPROC)glutGetProcAddress("glGetShaderiv");
+    pglGetShaderInfoLog = (PFNGLGETSHADERINFOLOGPROC)glutGetProcAddress("glGetShaderInfoLog");
+    pglCreateProgram = (PFNGLCREATEPROGRAMPROC)glutGetProcAddress("glCreateProgram");
+    pglAttachShader = (PFNGLATTACHSHADERPROC)glutGetProcAddress("glAttachShader");
+    pglBindAttribLocation = (PFNGLBINDATTRIBLOCATIONPROC)glutGetProcAddress("glBindAttribLocation");
+    pglLinkProgram = (PFNGLLINKPROGRAMPROC)glutGetProcAddress("glLinkProgram");
+    pglGetProgramiv = (PFNGLGETPROGRAMIVPROC)glutGetProcAddress("glGetProgramiv");
+    pglGetProgramInfoLog = (PFNGLGETPROGRAMINFOLOGPROC)glutGetProcAddress("glGetProgramInfoLog");
+    pglUseProgram = (PFNGLUSEPROGRAMPROC)glutGetProcAddress("glUseProgram");
+    pglGenBuffers = (PFNGLGENBUFFERSPROC)glutGetProcAddress("glGenBuffers");
+    pglBindBuffer = (PFNGLBINDBUFFERPROC)glutGetProcAddress("glBindBuffer");
+    pglBufferData = (PFNGLBUFFERDATAPROC)glutGetProcAddress("glBufferData");
+    pglBufferSubData = (PFNGLBUFFERSUBDATAPROC)glutGetProcAddress("glBufferSubData");
+    pglDeleteBuffers = (PFNGLDELETEBUFFERSPROC)glutGetProcAddress("glDeleteBuffers");
+    pglEnableVertexAttribArray = (PFNGLENABLEVERTEXATTRIBARRAYPROC)glutGetProcAddress("glEnableVertexAttribArray");
+    pglDisableVertexAttribArray = (PFNGLDISABLEVERTEXATTRIBARRAYPROC)glutGetProcAddress("glDisableVertexAttribArray");
+    pglVertexAttribPointer = (PFNGLVERTEXATTRIBPOINTERPROC)glutGetProcAddress("glVertexAttribPointer");
+    pglVertexAttribDivisor = (PFNGLVERTEXATTRIBDIVISORPROC)glutGetProcAddress(
+        arbInstancing ? "glVertexAttribDivisorARB" : "glVertexAttribDivisor");
+    pglDrawArraysInstanced = (PFNGLDRAWARRAYSINSTANCEDPROC)glutGetProcAddress(
+        arbInstancing ? "glDrawArraysInstancedARB" : "glDrawArraysInstanced");
+    pglDeleteShader = (PFNGLDELETESHADERPROC)glutGetProcAddress("glDeleteShader");
+    pglDeleteProgram = (PFNGLDELETEPROGRAMPROC)glutGetProcAddress("glDeleteProgram");
+    pglGenFramebuffers = (PFNGLGENFRAMEBUFFERSPROC)glutGetProcAddress("glGenFramebuffers");
+    pglBindFramebuffer = (PFNGLBINDFRAMEBUFFERPROC)glutGetProcAddress("glBindFramebuffer");
+    pglDeleteFramebuffers = (PFNGLDELETEFRAMEBUFFERSPROC)glutGetProcAddress("glDeleteFramebuffers");
+    pglCheckFramebufferStatus = (PFNGLCHECKFRAMEBUFFERSTATUSPROC)glutGetProcAddress("glCheckFramebufferStatus");
+    pglGenRenderbuffers = (PFNGLGENRENDERBUFFERSPROC)glutGetProcAddress("glGenRenderbuffers");
+    pglBindRenderbuffer = (PFNGLBINDRENDERBUFFERPROC)glutGetProcAddress("glBindRenderbuffer");
+    pglDeleteRenderbuffers = (PFNGLDELETERENDERBUFFERSPROC)glutGetProcAddress("glDeleteRenderbuffers");
+    pglRenderbufferStorage = (PFNGLRENDERBUFFERSTORAGEPROC)glutGetProcAddress("glRenderbufferStorage");
+    pglFramebufferRenderbuffer = (PFNGLFRAMEBUFFERRENDERBUFFERPROC)glutGetProcAddress("glFramebufferRenderbuffer");
+
+    if (!pglCreateShader || !pglShaderSource || !pglCompileShader || !pglGetShaderiv ||
+        !pglGetShaderInfoLog || !pglCreateProgram || !pglAttachShader || !pglBindAttribLocation ||
+        !pglLinkProgram || !pglGetProgramiv || !pglGetProgramInfoLog || !pglUseProgram ||
+        !pglGenBuffers || !pglBindBuffer || !pglBufferData || !pglBufferSubData || !pglDeleteBuffers ||
+        !pglEnableVertexAttribArray || !pglDisableVertexAttribArray || !pglVertexAttribPointer ||
+        !pglVertexAttribDivisor || !pglDrawArraysInstanced || !pglDeleteShader || !pglDeleteProgram ||
+        !pglGenFramebuffers || !pglBindFramebuffer || !pglDeleteFramebuffers ||
+        !pglCheckFramebufferStatus || !pglGenRenderbuffers || !pglBindRenderbuffer ||
+        !pglDeleteRenderbuffers || !pglRenderbufferStorage || !pglFramebufferRenderbuffer) {
+        cerr << "Error: el contexto OpenGL no soporta dibujo instanciado, se usar la CPU" << endl;
+        return false;
+    }
+
+    GLuint vs = compileShader(GL_VERTEX_SHADER, figureVertexShader);
+    GLuint fs = compileShader(GL_FRAGMENT_SHADER, figureFragmentShader);
+    if (!vs || !fs) {
+        if (vs) pglDeleteShader(vs);
+        if (fs) pglDeleteShader(fs);
+        return false;
+    }
+
+    figureProgram = pglCreateProgram();
+    pglAttachShader(figureProgram, vs);
+    pglAttachShader(figureProgram, fs);
+    pglBindAttribLocation(figureProgram, ATTR_CORNER, "aCorner");
+    pglBindAttribLocation(figureProgram, ATTR_TYPE, "aType");
+    pglBindAttribLocation(figureProgram, ATTR_P0, "aP0");
+    pglBindAttribLocation(figureProgram, ATTR_P1, "aP1");
+    pglBindAttribLocation(figureProgram, ATTR_COLOR, "aColor");
+    pglBindAttribLocation(figureProgram, ATTR_THICKNESS, "aThickness");
+    pglLinkProgram(figureProgram);
+
+    // El programa conserva los shaders enlazados; se liberan al borrarlo
+    pglDeleteShader(vs);
+    pglDeleteShader(fs);
+
+    GLint ok = GL_FALSE;
+    pglGetProgramiv(figureProgram, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        pglGetProgramInfoLog(figureProgram, sizeof(log), nullptr, log);
+        cerr << "Error al enlazar el programa de shaders: " << log << endl;
+        pglDeleteProgram(figureProgram);
+        figureProgram = 0;
+        return false;
+    }
+
+    // Esquinas del quad (triangle strip) compartidas por todas las instancias
+    const float corners[] = { 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f };
+    pglGenBuffers(1, &cornerBuffer);
+    pglBindBuffer(GL_ARRAY_BUFFER, cornerBuffer);
+    pglBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    pglBindBuffer(GL_ARRAY_BUFFER, 0);
+    return true;
+}
+
+// Cada capa tiene su propio buffer de instancias, que solo se vuelve a subir cuando cambia
+void fillInstance(FigureInstance& inst, const Figure& figure) {
+    inst.type = figure.type;
+    inst.p0[0] = figure.points[0].x;
+    inst.p0[1] = figure.points[0].y;
+    inst.p1[0] = figure.points[1].x;
+    inst.p1[1] = figure.points[1].y;
+    inst.color[0] = figure.color.r;
+    inst.color[1] = figure.color.g;
+    inst.color[2] = figure.color.b;
+    inst.thickness = figure.thickness;
+}
+
+// Sube solo las instancias marcadas y las aadidas al final; arrastrar una
+// seleccin cuesta lo que ocupa la seleccin, no la capa entera
+void updateLayerInstances(Layer& layer) {
+    const vector<Figure>& figures = layer.figures;
+    GLsizei count = static_cast<GLsizei>(figures.size());
+    if (layer.instanceBuffer == 0) pglGenBuffers(1, &layer.instanceBuffer);
+    pglBindBuffer(GL_ARRAY_BUFFER, layer.instanceBuffer);
+
+    if (layer.instancesDirty || count > layer.instanceCapacity) {
+        // La capacidad crece al doble para no realojar el buffer en cada figura nueva
+        if (count > layer.instanceCapacity) {
+            layer.instanceCapacity = max(count, 2 * layer.instanceCapacity);
+            pglBufferData(GL_ARRAY_BUFFER, layer.instanceCapacity * sizeof(FigureInstance), nullptr, GL_DYNAMIC_DRAW);
+        }
+        instances.resize(count);
+        for (GLsizei i = 0; i < count; i++) fillInstance(instances[i], figures[i]);
+        if (count > 0) pglBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(FigureInstance), instances.data());
+    } else {
+        vector<int>& dirty = layer.dirtyInstances;
+        for (GLsizei i = layer.instanceCount; i < count; i++) dirty.push_back(i);
+        sort(dirty.begin(), dirty.end());
+        dirty.erase(unique(dirty.begin(), dirty.end()), dirty.end());
+
+        // Una subida por cada tramo de ndices consecutivos
+        size_t k = 0;
+        while (k < dirty.size() && dirty[k] < count) {
+            int first = dirty[k];
+            instances.clear();
+            while (k < dirty.size() && dirty[k] < count && dirty[k] == first + static_cast<int>(instances.size())) {
+                instances.emplace_back();
+                fillInstance(instances.back(), figures[dirty[k]]);
+                k++;
+            }
+            pglBufferSubData(GL_ARRAY_BUFFER, first * sizeof(FigureInstance),
+                             instances.size() * sizeof(FigureInstance), instances.data());
+        }
+    }
+    layer.instanceCount = count;
+    layer.instancesDirty = false;
+    layer.dirtyInstances.clear();
+}
+
+// Libera los buffers de instancias antes de descartar las capas
+void releaseLayerBuffers() {
+    for (auto& layer : layers) {
+        if (layer.instanceBuffer) pglDeleteBuffers(1, &layer.instanceBuffer);
+        layer.instanceBuffer = 0;
+        layer.instanceCount = 0;
+        layer.instanceCapacity = 0;
+        layer.instancesDirty = true;
+        layer.dirtyInstances.clear();
+    }
+}
+
+void drawFiguresGPU() {
+    pglUseProgram(figureProgram);
+
+    pglBindBuffer(GL_ARRAY_BUFFER, cornerBuffer);
+    pglEnableVertexAttribArray(ATTR_CORNER);
+    pglVertexAttribPointer(ATTR_CORNER, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    const GLsizei stride = sizeof(FigureInstance);
+    struct { GLuint index; GLint size; size_t offset; } attribs[] = {
+        { ATTR_TYPE, 1, offsetof(FigureInstance, type) },
+        { ATTR_P0, 2, offsetof(FigureInstance, p0) },
+        { ATTR_P1, 2, offsetof(FigureInstance, p1) },
+        { ATTR_COLOR, 3, offsetof(FigureInstance, color) },
+        { ATTR_THICKNESS, 1, offsetof(FigureInstance, thickness) },
+    };
+    for (const auto& a : attribs) {
+        pglEnableVertexAttribArray(a.index);
+        pglVertexAttribDivisor(a.index, 1);
+    }
+
+    // Una llamada instanciada por capa visible, en orden
+    for (auto& layer : layers) {
+        if (!layer.visible) continue;
+        if (layer.instancesDirty || !layer.dirtyInstances.empty() ||
+            layer.instanceCount != static_cast<GLsizei>(layer.figures.size())) {
+            updateLayerInstances(layer);
+        }
+        if (layer.instanceCount == 0) continue;
+
+        pglBindBuffer(GL_ARRAY_BUFFER, layer.instanceBuffer);
+        for (const auto& a : attribs) {
+            pglVertexAttribPointer(a.index, a.size, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(a.offset));
+        }
+        pglDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, layer.instanceCount);
+    }
+
+    // Restaurar el estado para el pipeline fijo (glBegin/glEnd)
+    for (const auto& a : attribs) {
+        pglVertexAttribDivisor(a.index, 0);
+        pglDisableVertexAttribArray(a.index);
+    }
+    pglDisableVertexAttribArray(ATTR_CORNER);
+    pglBindBuffer(GL_ARRAY_BUFFER, 0);
+    pglUseProgram(0);
+}
+
+struct RenderDiff {
+    int cpuPixels, gpuPixels, diffPixels;
+};
+
+// Dibuja las figuras con ambos modos y cuenta los pxeles que difieren
+RenderDiff diffRenderers() {
+    vector<unsigned char> cpuPixels(3 * WINDOW_WIDTH * WINDOW_HEIGHT);
+    vector<unsigned char> gpuPixels(3 * WINDOW_WIDTH * WINDOW_HEIGHT);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
     glClear(GL_COLOR_BUFFER_BIT);
+    drawFiguresCPU();
+    glReadPixels(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT, GL_RGB, GL_UNSIGNED_BYTE, cpuPixels.data());
 
-    if (showGrid) drawGrid();
-    if (showAxes) drawAxes();
+    glClear(GL_COLOR_BUFFER_BIT);
+    drawFiguresGPU();
+    glReadPixels(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT, GL_RGB, GL_UNSIGNED_BYTE, gpuPixels.data());
+
+    RenderDiff diff = { 0, 0, 0 };
+    for (int i = 0; i < WINDOW_WIDTH * WINDOW_HEIGHT; i++) {
+        const unsigned char* c = &cpuPixels[3 * i];
+        const unsigned char* g = &gpuPixels[3 * i];
+        bool cpuInk = c[0] != 255 || c[1] != 255 || c[2] != 255;
+        bool gpuInk = g[0] != 255 || g[1] != 255 || g[2] != 255;
+        if (cpuInk) diff.cpuPixels++;
+        if (gpuInk) diff.gpuPixels++;
+        if (c[0] != g[0] || c[1] != g[1] || c[2] != g[2]) diff.diffPixels++;
+    }
+    return diff;
+}
 
-    // Dibujar todas las figuras
-    for (const auto& figure : figures) {
-        switch (figure.type) {
-            case 0: // Lnea directa
-                if (figure.points.size() >= 2)
-                    drawLineDirect(figure.points[0], figure.points[1], figure.color, figure.thickness);
-                break;
-            case 1: // Lnea DDA
-                if (figure.points.size() >= 2)
-                    drawLineDDA(figure.points[0], figure.points[1], figure.color, figure.thickness);
-                break;
-            case 2: // Crculo incremental
-                if (figure.points.size() >= 2) {
-                    int radius = static_cast<int>(sqrt(
-                        pow(figure.points[1].x - figure.points[0].x, 2) +
-                        pow(figure.points[1].y - figure.points[0].y, 2)
-                    ));
-                    drawCircleIncremental(figure.points[0], radius, figure.color, figure.thickness);
+void compareRenderers() {
+    if (!gpuAvailable) {
+        cout << "El modo GPU no est disponible" << endl;
+        return;
+    }
+
+    RenderDiff diff = diffRenderers();
+    cout << "Comparacin CPU vs GPU: " << diff.cpuPixels << " pxeles (CPU), " << diff.gpuPixels
+         << " pxeles (GPU), " << diff.diffPixels << " diferentes";
+    if (diff.cpuPixels > 0) cout << " (" << 100.0 * diff.diffPixels / diff.cpuPixels << "% del trazo CPU)";
+    cout << endl;
+}
+
+// Prueba sin interaccin (--compare): dibuja un conjunto fijo de figuras de cada
+// tipo y grosor con ambos modos y falla si los pxeles distintos superan el
+// umbral, expresado como fraccin del trazo CPU. Se dibuja en un framebuffer
+// propio: el back buffer de una ventana que nunca se mostr no tiene contenido
+// definido
+const char* FIGURE_TYPE_NAMES[5] = {
+    "Lnea directa", "Lnea DDA", "Crculo incremental", "Crculo punto medio", "Elipse"
+};
+const int RENDER_TEST_THICKNESS[4] = { 1, 2, 3, 5 };
+// Fraccin mxima de pxeles distintos por tipo; el incremental deja ms margen
+// porque la precisin de sin/cos en el shader depende del driver
+const float RENDER_TEST_THRESHOLDS[5] = {
+    0.02f, // Lnea directa
+    0.02f, // Lnea DDA
+    0.05f, // Crculo incremental
+    0.02f, // Crculo punto medio
+    0.02f, // Elipse
+};
+
+void addTestFigures(int type, int thickness) {
+    // 6 x 4 celdas de 120 x 120 con orientaciones y tamaos distintos
+    for (int k = 0; k < 24; k++) {
+        int cx = -300 + (k % 6) * 120;
+        int cy = -180 + (k / 6) * 120;
+        double angle = k * M_PI / 12;
+        int length = 20 + 2 * k;
+
+        Figure figure;
+        figure.type = type;
+        figure.points.push_back(Point(cx, cy));
+        figure.points.push_back(Point(cx + static_cast<int>(round(length * cos(angle))),
+                                      cy + static_cast<int>(round(length * sin(angle)))));
+        figure.color = Color(0.0f, 0.0f, 0.0f);
+        figure.thickness = thickness;
+        layers[currentLayer].figures.push_back(figure);
+    }
+}
+
+int runRendererTest() {
+    if (!gpuAvailable) {
+        cerr << "Error: el modo GPU no est disponible" << endl;
+        return 2;
+    }
+
+    GLuint framebuffer = 0, colorBuffer = 0;
+    pglGenFramebuffers(1, &framebuffer);
+    pglBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    pglGenRenderbuffers(1, &colorBuffer);
+    pglBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    pglRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, WINDOW_WIDTH, WINDOW_HEIGHT);
+    pglFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    bool complete = pglCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    auto releaseFramebuffer = [&]() {
+        pglBindFramebuffer(GL_FRAMEBUFFER, 0);
+        pglDeleteRenderbuffers(1, &colorBuffer);
+        pglDeleteFramebuffers(1, &framebuffer);
+    };
+    if (!complete) {
+        cerr << "Error: no se pudo crear el framebuffer de la prueba" << endl;
+        releaseFramebuffer();
+        return 2;
+    }
+    glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+
+    int failures = 0;
+    for (int type = 0; type < 5; type++) {
+        for (int t = 0; t < 4; t++) {
+            releaseLayerBuffers();
+            layers.assign(1, Layer());
+            currentLayer = 0;
+            addTestFigures(type, RENDER_TEST_THICKNESS[t]);
+
+            RenderDiff diff = diffRenderers();
+            float ratio = diff.cpuPixels > 0 ? static_cast<float>(diff.diffPixels) / diff.cpuPixels : 0.0f;
+            bool ok = ratio <= RENDER_TEST_THRESHOLDS[type];
+            if (!ok) failures++;
+
+            cout << FIGURE_TYPE_NAMES[type] << ", " << RENDER_TEST_THICKNESS[t] << " px: "
+                 << diff.diffPixels << " de " << diff.cpuPixels << " pxeles distintos ("
+                 << 100.0f * ratio << "%, umbral " << 100.0f * RENDER_TEST_THRESHOLDS[type] << "%) "
+                 << (ok ? "OK" : "FALLA") << endl;
+        }
+    }
+
+    releaseLayerBuffers();
+    releaseFramebuffer();
+    return failures > 0 ? 1 : 0;
+}
+
+// Cach por capa: el modo CPU guarda el rasterizado de cada capa y solo vuelve
+// a rasterizar las baldosas que tocan sus regiones invalidadas. El cuadro
+// final se compone mezclando las cachs de las capas visibles en orden.
+Rect figureBounds(const Figure& figure) {
+    Point c = figure.points[0];
+    Point q = figure.points[1];
+    Rect r;
+    switch (figure.type) {
+        case 2:
+        case 3: {
+            int dx = q.x - c.x;
+            int dy = q.y - c.y;
+            int radius = static_cast<int>(sqrt(static_cast<double>(dx * dx + dy * dy)));
+            r = Rect(c.x - radius, c.y - radius, c.x + radius, c.y + radius);
+            break;
+        }
+        case 4: {
+            int rx = abs(q.x - c.x);
+            int ry = abs(q.y - c.y);
+            r = Rect(c.x - rx, c.y - ry, c.x + rx, c.y + ry);
+            break;
+        }
+        default:
+            r = Rect(min(c.x, q.x), min(c.y, q.y), max(c.x, q.x), max(c.y, q.y));
+            break;
+    }
+    // Margen para el grosor del punto y el redondeo de los algoritmos
+    int pad = figure.thickness + 2;
+    return Rect(r.minX - pad, r.minY - pad, r.maxX + pad, r.maxY + pad);
+}
+
+// Invalida una regin de la capa actual, donde ocurren todas las ediciones
+void invalidateRegion(const Rect& region) {
+    if (!region.empty()) layers[currentLayer].dirtyRegions.push_back(region);
+}
+
+// Marca la instancia GPU de una figura de la capa actual; en modo CPU nadie
+// consume la lista, as que pasado el tamao de la capa basta una subida completa
+void invalidateInstance(int index) {
+    Layer& layer = layers[currentLayer];
+    if (layer.instancesDirty) return;
+    layer.dirtyInstances.push_back(index);
+    if (layer.dirtyInstances.size() > layer.figures.size()) {
+        layer.instancesDirty = true;
+        layer.dirtyInstances.clear();
+    }
+}
+
+void invalidateLayer(Layer& layer) {
+    layer.cacheValid = false;
+    layer.dirtyRegions.clear();
+    layer.instancesDirty = true;
+    layer.dirtyInstances.clear();
+}
+
+bool isFloating(size_t i) {
+    return i < floatingFigures.size() && floatingFigures[i];
+}
+
+// Marca las baldosas de la ventana que toca una regin en coordenadas del mundo
+void markDirtyTiles(vector<char>& tiles, const Rect& region) {
+    int x0 = max(region.minX + WINDOW_WIDTH/2, 0);
+    int y0 = max(region.minY + WINDOW_HEIGHT/2, 0);
+    int x1 = min(region.maxX + WINDOW_WIDTH/2, WINDOW_WIDTH - 1);
+    int y1 = min(region.maxY + WINDOW_HEIGHT/2, WINDOW_HEIGHT - 1);
+    if (x1 < x0 || y1 < y0) return;
+
+    for (int ty = y0 / TILE_SIZE; ty <= y1 / TILE_SIZE; ty++) {
+        for (int tx = x0 / TILE_SIZE; tx <= x1 / TILE_SIZE; tx++) {
+            tiles[ty * TILES_X + tx] = 1;
+        }
+    }
+}
+
+bool touchesDirtyTiles(const vector<char>& tiles, const Rect& bounds) {
+    int x0 = max(bounds.minX + WINDOW_WIDTH/2, 0);
+    int y0 = max(bounds.minY + WINDOW_HEIGHT/2, 0);
+    int x1 = min(bounds.maxX + WINDOW_WIDTH/2, WINDOW_WIDTH - 1);
+    int y1 = min(bounds.maxY + WINDOW_HEIGHT/2, WINDOW_HEIGHT - 1);
+    if (x1 < x0 || y1 < y0) return false;
+
+    for (int ty = y0 / TILE_SIZE; ty <= y1 / TILE_SIZE; ty++) {
+        for (int tx = x0 / TILE_SIZE; tx <= x1 / TILE_SIZE; tx++) {
+            if (tiles[ty * TILES_X + tx]) return true;
+        }
+    }
+    return false;
+}
+
+// Agrupa las baldosas marcadas en rectngulos (en pxeles de la ventana): tramos
+// por fila que se extienden hacia arriba mientras la fila siguiente repita el tramo
+vector<Rect> dirtyTileRects(const vector<char>& tiles) {
+    vector<Rect> tileRects;
+    for (int ty = 0; ty < TILES_Y; ty++) {
+        int tx = 0;
+        while (tx < TILES_X) {
+            if (!tiles[ty * TILES_X + tx]) { tx++; continue; }
+            int start = tx;
+            while (tx < TILES_X && tiles[ty * TILES_X + tx]) tx++;
+
+            bool extended = false;
+            for (auto& r : tileRects) {
+                if (r.maxY == ty - 1 && r.minX == start && r.maxX == tx - 1) {
+                    r.maxY = ty;
+                    extended = true;
+                    break;
                 }
-                break;
-            case 3: // Crculo punto medio
-                if (figure.points.size() >= 2) {
-                    int radius = static_cast<int>(sqrt(
-                        pow(figure.points[1].x - figure.points[0].x, 2) +
-                        pow(figure.points[1].y - figure.points[0].y, 2)
-                    ));
-                    drawCircleMidpoint(figure.points[0], radius, figure.color, figure.thickness);
+            }
+            if (!extended) tileRects.push_back(Rect(start, ty, tx - 1, ty));
+        }
+    }
+
+    vector<Rect> rects;
+    for (const auto& r : tileRects) {
+        rects.push_back(Rect(r.minX * TILE_SIZE, r.minY * TILE_SIZE,
+                             min((r.maxX + 1) * TILE_SIZE, WINDOW_WIDTH) - 1,
+                             min((r.maxY + 1) * TILE_SIZE, WINDOW_HEIGHT) - 1));
+    }
+    return rects;
+}
+
+// Vuelve a rasterizar las baldosas marcadas de una capa. Se limpian los
+// rectngulos sucios y se recorren las figuras una sola vez: cada caja envolvente
+// se calcula una vez y se dibujan, en orden, las que tocan alguna baldosa sucia.
+// Fuera de los rectngulos el bfer queda alterado, pero nunca se lee.
+void rasterizeLayerTiles(int layerIndex, const vector<char>& tiles) {
+    Layer& layer = layers[layerIndex];
+    vector<Rect> rects = dirtyTileRects(tiles);
+    if (rects.empty()) return;
+
+    Rect area;
+    for (const auto& r : rects) area = area.unite(r);
+
+    vector<size_t> dirtyFigures;
+    for (size_t i = 0; i < layer.figures.size(); i++) {
+        if (layerIndex == currentLayer && isFloating(i)) continue;
+        if (touchesDirtyTiles(tiles, figureBounds(layer.figures[i]))) dirtyFigures.push_back(i);
+    }
+
+    auto drawDirtyFigures = [&](float background) {
+        glEnable(GL_SCISSOR_TEST);
+        glClearColor(background, background, background, 0.0f);
+        for (const auto& r : rects) {
+            glScissor(r.minX, r.minY, r.maxX - r.minX + 1, r.maxY - r.minY + 1);
+            glClear(GL_COLOR_BUFFER_BIT);
+        }
+        glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+        glScissor(area.minX, area.minY, area.maxX - area.minX + 1, area.maxY - area.minY + 1);
+        for (size_t i : dirtyFigures) drawFigureCPU(layer.figures[i]);
+        glDisable(GL_SCISSOR_TEST);
+    };
+
+    // Leer cada rectngulo directamente en su posicin dentro del destino
+    auto readRects = [&](GLenum format, unsigned char* target) {
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glPixelStorei(GL_PACK_ROW_LENGTH, WINDOW_WIDTH);
+        for (const auto& r : rects) {
+            glPixelStorei(GL_PACK_SKIP_PIXELS, r.minX);
+            glPixelStorei(GL_PACK_SKIP_ROWS, r.minY);
+            glReadPixels(r.minX, r.minY, r.maxX - r.minX + 1, r.maxY - r.minY + 1,
+                         format, GL_UNSIGNED_BYTE, target);
+        }
+        glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+        glPixelStorei(GL_PACK_SKIP_PIXELS, 0);
+        glPixelStorei(GL_PACK_SKIP_ROWS, 0);
+    };
+
+    // Fondo transparente: solo el trazo de la capa queda opaco
+    drawDirtyFigures(0.0f);
+    readRects(GL_RGBA, layer.cache.data());
+    if (destinationAlpha) return;
+
+    // Sin canal alfa en el framebuffer: se repite el dibujo sobre fondo blanco.
+    // Un pxel con trazo tiene el mismo color en ambas pasadas; uno vaco pasa
+    // de negro a blanco
+    drawDirtyFigures(1.0f);
+    coverageScratch.resize(3 * WINDOW_WIDTH * WINDOW_HEIGHT);
+    readRects(GL_RGB, coverageScratch.data());
+    for (const auto& r : rects) {
+        for (int y = r.minY; y <= r.maxY; y++) {
+            for (int x = r.minX; x <= r.maxX; x++) {
+                unsigned char* c = &layer.cache[4 * (y * WINDOW_WIDTH + x)];
+                const unsigned char* w = &coverageScratch[3 * (y * WINDOW_WIDTH + x)];
+                c[3] = (c[0] == w[0] && c[1] == w[1] && c[2] == w[2]) ? 255 : 0;
+            }
+        }
+    }
+}
+
+void updateLayerCache(int layerIndex) {
+    Layer& layer = layers[layerIndex];
+    vector<char> tiles(TILES_X * TILES_Y, 0);
+
+    if (!layer.cacheValid) {
+        layer.cache.assign(4 * WINDOW_WIDTH * WINDOW_HEIGHT, 0);
+        fill(tiles.begin(), tiles.end(), 1);
+        layer.cacheValid = true;
+    } else {
+        if (layer.dirtyRegions.empty()) return;
+        for (const auto& region : layer.dirtyRegions) markDirtyTiles(tiles, region);
+    }
+    layer.dirtyRegions.clear();
+    rasterizeLayerTiles(layerIndex, tiles);
+}
+
+void drawLayerCache(const Layer& layer) {
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glRasterPos2i(-WINDOW_WIDTH/2, -WINDOW_HEIGHT/2);
+    glDrawPixels(WINDOW_WIDTH, WINDOW_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, layer.cache.data());
+    glDisable(GL_BLEND);
+}
+
+// Capas
+// La seleccin y la figura a medio dibujar pertenecen a la capa actual: se
+// abandonan antes de cambiarla, moverla u ocultarla
+void resetLayerEditing() {
+    clearSelection();
+    drawing = false;
+    currentPoints.clear();
+}
+
+void addLayer() {
+    resetLayerEditing();
+    Layer layer;
+    layer.name = "Capa " + to_string(layers.size() + 1);
+    layers.push_back(layer);
+    currentLayer = static_cast<int>(layers.size()) - 1;
+}
+
+void printLayers() {
+    cout << "Capas (de abajo hacia arriba):" << endl;
+    for (size_t i = 0; i < layers.size(); i++) {
+        cout << (static_cast<int>(i) == currentLayer ? " > " : "   ") << layers[i].name
+             << " [" << (layers[i].visible ? "visible" : "oculta") << "] "
+             << layers[i].figures.size() << " figuras" << endl;
+    }
+}
+
+// Mueve la capa actual en el orden de dibujo; las cachs se conservan
+void moveCurrentLayer(int delta) {
+    int target = currentLayer + delta;
+    if (target < 0 || target >= static_cast<int>(layers.size())) return;
+    resetLayerEditing();
+    swap(layers[currentLayer], layers[target]);
+    currentLayer = target;
+}
+
+void selectNextLayer() {
+    resetLayerEditing();
+    currentLayer = (currentLayer + 1) % layers.size();
+}
+
+// Pide el nombre por consola; la ventana no se redibuja mientras se escribe
+void renameCurrentLayer() {
+    cout << "Nuevo nombre para " << layers[currentLayer].name << " (vaco para conservarlo): " << flush;
+    string name;
+    if (!getline(cin, name)) {
+        cin.clear();
+        cout << endl;
+        return;
+    }
+    if (!name.empty()) layers[currentLayer].name = name;
+}
+
+// Las ediciones sobre una capa oculta no se veran en pantalla: se rechazan
+bool currentLayerEditable() {
+    if (layers[currentLayer].visible) return true;
+    cout << "La capa actual est oculta; mustrela (H) para editarla" << endl;
+    return false;
+}
+
+void toggleCurrentLayerVisibility() {
+    resetLayerEditing();
+    layers[currentLayer].visible = !layers[currentLayer].visible;
+}
+
+void clearAllLayers() {
+    clearSelection();
+    for (auto& layer : layers) {
+        layer.figures.clear();
+        layer.redoStack.clear();
+        invalidateLayer(layer);
+    }
+}
+
+// Seleccin y transformaciones afines
+int pickFigure(Point p) {
+    vector<Figure>& figures = layers[currentLayer].figures;
+    for (int i = static_cast<int>(figures.size()) - 1; i >= 0; i--) {
+        if (figureBounds(figures[i]).contains(p)) return i;
+    }
+    return -1;
+}
+
+Rect selectionBounds() {
+    vector<Figure>& figures = layers[currentLayer].figures;
+    Rect bounds;
+    for (int i : selection) bounds = bounds.unite(figureBounds(figures[i]));
+    return bounds;
+}
+
+// Copia los puntos de la seleccin a arreglos separados x/y para transformarlos en lote
+void gatherSelection() {
+    vector<Figure>& figures = layers[currentLayer].figures;
+    selX.clear();
+    selY.clear();
+    for (int i : selection) {
+        for (const Point& pt : figures[i].points) {
+            selX.push_back(pt.x);
+            selY.push_back(pt.y);
+        }
+    }
+}
+
+void applyAffine(const Affine& m, const float* xs, const float* ys, float* outXs, float* outYs, size_t n) {
+    for (size_t k = 0; k < n; k++) {
+        outXs[k] = m.a * xs[k] + m.b * ys[k] + m.tx;
+        outYs[k] = m.c * xs[k] + m.d * ys[k] + m.ty;
+    }
+}
+
+// Transforma la seleccin a partir de las coordenadas reunidas en selX/selY
+void transformSelection(const Affine& m) {
+    vector<Figure>& figures = layers[currentLayer].figures;
+    size_t n = selX.size();
+    outX.resize(n);
+    outY.resize(n);
+    applyAffine(m, selX.data(), selY.data(), outX.data(), outY.data(), n);
+
+    float scale = sqrt(fabs(m.a * m.d - m.b * m.c));
+    size_t k = 0;
+    for (int i : selection) {
+        Figure& figure = figures[i];
+        size_t first = k;
+        for (Point& pt : figure.points) {
+            pt.x = lround(outX[k]);
+            pt.y = lround(outY[k]);
+            k++;
+        }
+        // Las elipses son paralelas a los ejes: sus semiejes solo se escalan
+        if (figure.type == 4) {
+            figure.points[1].x = figure.points[0].x + lround(scale * (selX[first + 1] - selX[first]));
+            figure.points[1].y = figure.points[0].y + lround(scale * (selY[first + 1] - selY[first]));
+        }
+    }
+    for (int i : selection) invalidateInstance(i);
+}
+
+void beginMove(Point start) {
+    vector<Figure>& figures = layers[currentLayer].figures;
+    floatingFigures.assign(figures.size(), 0);
+    for (int i : selection) {
+        floatingFigures[i] = 1;
+        invalidateRegion(figureBounds(figures[i])); // Regin que deja libre
+    }
+    gatherSelection();
+    dragStart = start;
+    movingSelection = true;
+}
+
+void endMove() {
+    vector<Figure>& figures = layers[currentLayer].figures;
+    for (int i : selection) invalidateRegion(figureBounds(figures[i]));
+    floatingFigures.clear();
+    movingSelection = false;
+}
+
+void clearSelection() {
+    if (movingSelection) endMove();
+    boxSelecting = false;
+    selection.clear();
+}
+
+// Escala o rota la seleccin alrededor del centro de su caja envolvente
+void transformSelectionAroundCenter(float scale, float angle) {
+    if (selection.empty() || movingSelection) return;
+    vector<Figure>& figures = layers[currentLayer].figures;
+
+    Rect bounds = selectionBounds();
+    float cx = (bounds.minX + bounds.maxX) * 0.5f;
+    float cy = (bounds.minY + bounds.maxY) * 0.5f;
+    float cs = scale * cos(angle);
+    float sn = scale * sin(angle);
+
+    Affine m;
+    m.a = cs;  m.b = -sn; m.tx = cx - cs * cx + sn * cy;
+    m.c = sn;  m.d = cs;  m.ty = cy - sn * cx - cs * cy;
+
+    for (int i : selection) invalidateRegion(figureBounds(figures[i]));
+    gatherSelection();
+    transformSelection(m);
+    for (int i : selection) invalidateRegion(figureBounds(figures[i]));
+}
+
+void drawSelection() {
+    vector<Figure>& figures = layers[currentLayer].figures;
+    glColor3f(0.0f, 0.4f, 1.0f);
+    for (int i : selection) {
+        Rect r = figureBounds(figures[i]);
+        glBegin(GL_LINE_LOOP);
+        glVertex2i(r.minX, r.minY);
+        glVertex2i(r.maxX, r.minY);
+        glVertex2i(r.maxX, r.maxY);
+        glVertex2i(r.minX, r.maxY);
+        glEnd();
+    }
+
+    if (boxSelecting) {
+        glBegin(GL_LINE_LOOP);
+        glVertex2i(dragStart.x, dragStart.y);
+        glVertex2i(dragCurrent.x, dragStart.y);
+        glVertex2i(dragCurrent.x, dragCurrent.y);
+        glVertex2i(dragStart.x, dragCurrent.y);
+        glEnd();
+    }
+}
+
+void selectMouse(int state, Point p) {
+    vector<Figure>& figures = layers[currentLayer].figures;
+    if (state == GLUT_DOWN) {
+        bool additive = (glutGetModifiers() & GLUT_ACTIVE_SHIFT) != 0;
+        int hit = pickFigure(p);
+
+        if (hit < 0) {
+            // Clic en vaco: seleccin por rectngulo
+            if (!additive) selection.clear();
+            boxSelecting = true;
+            dragStart = p;
+            dragCurrent = p;
+            return;
+        }
+
+        if (find(selection.begin(), selection.end(), hit) == selection.end()) {
+            if (!additive) selection.clear();
+            selection.push_back(hit);
+        }
+        beginMove(p);
+    } else {
+        if (movingSelection) endMove();
+
+        if (boxSelecting) {
+            Rect box(min(dragStart.x, dragCurrent.x), min(dragStart.y, dragCurrent.y),
+                     max(dragStart.x, dragCurrent.x), max(dragStart.y, dragCurrent.y));
+            // Mscara de pertenencia: con shift la seleccin previa puede ser grande
+            vector<char> selected(figures.size(), 0);
+            for (int i : selection) selected[i] = 1;
+            for (int i = 0; i < static_cast<int>(figures.size()); i++) {
+                if (!selected[i] && box.containsRect(figureBounds(figures[i]))) {
+                    selected[i] = 1;
+                    selection.push_back(i);
                 }
-                break;
-            case 4: // Elipse
-                if (figure.points.size() >= 2) {
-                    int rx = abs(figure.points[1].x - figure.points[0].x);
-                    int ry = abs(figure.points[1].y - figure.points[0].y);
-                    drawEllipseMidpoint(figure.points[0], rx, ry, figure.color, figure.thickness);
+            }
+            boxSelecting = false;
+        }
+    }
+}
+
+// Callbacks de OpenGL/GLUT
+void display() {
+    // Dibujar todas las figuras
+    if (useGPU && gpuAvailable) {
+        glClear(GL_COLOR_BUFFER_BIT);
+        if (showGrid) drawGrid();
+        if (showAxes) drawAxes();
+        drawFiguresGPU();
+    } else {
+        // Solo se rasterizan las regiones invalidadas de cada capa visible
+        for (size_t i = 0; i < layers.size(); i++) {
+            if (layers[i].visible) updateLayerCache(i);
+        }
+
+        glClear(GL_COLOR_BUFFER_BIT);
+        if (showGrid) drawGrid();
+        if (showAxes) drawAxes();
+
+        for (size_t i = 0; i < layers.size(); i++) {
+            if (!layers[i].visible) continue;
+            drawLayerCache(layers[i]);
+
+            // Las figuras arrastradas se rasterizan cada cuadro sobre su capa
+            if (static_cast<int>(i) == currentLayer) {
+                for (int j : selection) {
+                    if (isFloating(j)) drawFigureCPU(layers[i].figures[j]);
                 }
-                break;
+            }
         }
     }
 
+    if (currentTool == 5) drawSelection();
+
     // Dibujar figura actual en proceso
     if (drawing && currentPoints.size() > 0) {
         switch (currentTool) {
@@ -386,10 +1547,21 @@ void display() {
 }
 
 void mouse(int button, int state, int x, int y) {
+    // Convertir coordenadas de pantalla a coordenadas del mundo
+    int worldX = x - WINDOW_WIDTH/2;
+    int worldY = WINDOW_HEIGHT/2 - y;
+
+    if (currentTool == 5) {
+        if (button == GLUT_LEFT_BUTTON) {
+            if (state == GLUT_DOWN && !currentLayerEditable()) return;
+            selectMouse(state, Point(worldX, worldY));
+            glutPostRedisplay();
+        }
+        return;
+    }
+
     if (button == GLUT_LEFT_BUTTON && state == GLUT_DOWN) {
-        // Convertir coordenadas de pantalla a coordenadas del mundo
-        int worldX = x - WINDOW_WIDTH/2;
-        int worldY = WINDOW_HEIGHT/2 - y;
+        if (!currentLayerEditable()) return;
 
         if (!drawing) {
             drawing = true;
@@ -407,8 +1579,10 @@ void mouse(int button, int state, int x, int y) {
             newFigure.color = currentColor;
             newFigure.thickness = currentThickness;
 
-            figures.push_back(newFigure);
-            redoStack.clear(); // Limpiar pila de rehacer al hacer una nueva accin
+            layers[currentLayer].figures.push_back(newFigure);
+            invalidateRegion(figureBounds(newFigure));
+            invalidateInstance(layers[currentLayer].figures.size() - 1);
+            layers[currentLayer].redoStack.clear(); // Limpiar pila de rehacer al hacer una nueva accin
 
             drawing = false;
             currentPoints.clear();
@@ -418,7 +1592,27 @@ void mouse(int button, int state, int x, int y) {
     }
 }
 
+void motion(int x, int y) {
+    if (currentTool != 5) return;
+
+    int worldX = x - WINDOW_WIDTH/2;
+    int worldY = WINDOW_HEIGHT/2 - y;
+
+    if (movingSelection) {
+        Affine m;
+        m.tx = worldX - dragStart.x;
+        m.ty = worldY - dragStart.y;
+        transformSelection(m);
+        glutPostRedisplay();
+    } else if (boxSelecting) {
+        dragCurrent = Point(worldX, worldY);
+        glutPostRedisplay();
+    }
+}
+
 void keyboard(unsigned char key, int x, int y) {
+    vector<Figure>& figures = layers[currentLayer].figures;
+
     switch (key) {
         case 'g':
         case 'G':
@@ -430,8 +1624,7 @@ void keyboard(unsigned char key, int x, int y) {
             break;
         case 'c':
         case 'C':
-            figures.clear();
-            redoStack.clear();
+            clearAllLayers();
             break;
         case 's':
         case 'S':
@@ -439,23 +1632,64 @@ void keyboard(unsigned char key, int x, int y) {
             break;
         case 'z':
         case 'Z':
-            if (!figures.empty()) {
-                redoStack.push_back(figures.back());
+            if (!figures.empty() && currentLayerEditable()) {
+                clearSelection();
+                invalidateRegion(figureBounds(figures.back()));
+                layers[currentLayer].redoStack.push_back(figures.back());
                 figures.pop_back();
             }
             break;
         case 'y':
         case 'Y':
-            if (!redoStack.empty()) {
-                figures.push_back(redoStack.back());
-                redoStack.pop_back();
+            if (!layers[currentLayer].redoStack.empty() && currentLayerEditable()) {
+                clearSelection();
+                figures.push_back(layers[currentLayer].redoStack.back());
+                layers[currentLayer].redoStack.pop_back();
+                invalidateRegion(figureBounds(figures.back()));
+                invalidateInstance(figures.size() - 1);
+            }
+            break;
+        case 'r':
+        case 'R':
+            if (gpuAvailable) {
+                useGPU = !useGPU;
+                cout << "Modo de renderizado: " << (useGPU ? "GPU (instanciado)" : "CPU (referencia)") << endl;
             }
             break;
+        case '+':
+            if (currentTool == 5) transformSelectionAroundCenter(1.1f, 0.0f);
+            break;
+        case '-':
+            if (currentTool == 5) transformSelectionAroundCenter(1.0f / 1.1f, 0.0f);
+            break;
+        case '[':
+            if (currentTool == 5) transformSelectionAroundCenter(1.0f, M_PI / 12);
+            break;
+        case ']':
+            if (currentTool == 5) transformSelectionAroundCenter(1.0f, -M_PI / 12);
+            break;
+        case 'n':
+        case 'N':
+            addLayer();
+            printLayers();
+            break;
+        case 'l':
+        case 'L':
+            selectNextLayer();
+            printLayers();
+            break;
+        case 'h':
+        case 'H':
+            toggleCurrentLayerVisibility();
+            printLayers();
+            break;
     }
     glutPostRedisplay();
 }
 
 void menu(int value) {
+    vector<Figure>& figures = layers[currentLayer].figures;
+
     switch (value) {
         // Herramientas de dibujo
         case 0: currentTool = 0; break; // Lnea directa
@@ -463,6 +1697,7 @@ void menu(int value) {
         case 2: currentTool = 2; break; // Crculo incremental
         case 3: currentTool = 3; break; // Crculo punto medio
         case 4: currentTool = 4; break; // Elipse punto medio
+        case 5: currentTool = 5; break; // Seleccionar/mover
 
         // Colores
         case 10: currentColor = Color(0.0f, 0.0f, 0.0f); break; // Negro
@@ -484,16 +1719,35 @@ void menu(int value) {
         case 30: showGrid = !showGrid; break;
         case 31: showAxes = !showAxes; break;
         case 32: showCoords = !showCoords; break;
+        case 33: if (gpuAvailable) useGPU = !useGPU; break;
 
         // Herramientas
-        case 40: figures.clear(); redoStack.clear(); break; // Limpiar lienzo
+        case 40: clearAllLayers(); break; // Limpiar lienzo
         case 41:
-            if (!figures.empty()) {
-                redoStack.push_back(figures.back());
+            if (!figures.empty() && currentLayerEditable()) {
+                clearSelection();
+                invalidateRegion(figureBounds(figures.back()));
+                layers[currentLayer].redoStack.push_back(figures.back());
                 figures.pop_back();
             }
             break; // Deshacer
         case 42: exportToPPM("output.ppm"); break; // Exportar
+        case 43: compareRenderers(); break; // Comparar CPU vs GPU
+
+        // Capas
+        case 60: addLayer(); printLayers(); break; // Nueva capa
+        case 61: // Capa siguiente
+            selectNextLayer();
+            printLayers();
+            break;
+        case 62: // Mostrar/ocultar capa actual
+            toggleCurrentLayerVisibility();
+            printLayers();
+            break;
+        case 63: moveCurrentLayer(1); printLayers(); break; // Subir capa
+        case 64: moveCurrentLayer(-1); printLayers(); break; // Bajar capa
+        case 65: printLayers(); break;
+        case 66: renameCurrentLayer(); printLayers(); break; // Renombrar capa
 
         // Ayuda
         case 50:
@@ -504,6 +1758,12 @@ void menu(int value) {
             cout << "S: Exportar imagen" << endl;
             cout << "Z: Deshacer" << endl;
             cout << "Y: Rehacer" << endl;
+            cout << "R: Alternar renderizado CPU/GPU" << endl;
+            cout << "+/-: Escalar seleccin" << endl;
+            cout << "[/]: Rotar seleccin" << endl;
+            cout << "N: Nueva capa" << endl;
+            cout << "L: Cambiar de capa" << endl;
+            cout << "H: Mostrar/ocultar capa actual" << endl;
             break;
         case 51:
             cout << "Software CAD 2D Bsico" << endl;
@@ -521,6 +1781,7 @@ void createMenu() {
     glutAddMenuEntry("Crculo (Incremental)", 2);
     glutAddMenuEntry("Crculo (Punto Medio)", 3);
     glutAddMenuEntry("Elipse (Punto Medio)", 4);
+    glutAddMenuEntry("Seleccionar/Mover", 5);
 
     int colorMenu = glutCreateMenu(menu);
     glutAddMenuEntry("Negro", 10);
@@ -539,11 +1800,22 @@ void createMenu() {
     glutAddMenuEntry("Mostrar/Ocultar Cuadrcula", 30);
     glutAddMenuEntry("Mostrar/Ocultar Ejes", 31);
     glutAddMenuEntry("Mostrar Coordenadas", 32);
+    glutAddMenuEntry("Renderizado CPU/GPU", 33);
 
     int toolsMenu = glutCreateMenu(menu);
     glutAddMenuEntry("Limpiar Lienzo", 40);
     glutAddMenuEntry("Deshacer", 41);
     glutAddMenuEntry("Exportar Imagen", 42);
+    glutAddMenuEntry("Comparar CPU vs GPU", 43);
+
+    int layerMenu = glutCreateMenu(menu);
+    glutAddMenuEntry("Nueva Capa", 60);
+    glutAddMenuEntry("Capa Siguiente", 61);
+    glutAddMenuEntry("Mostrar/Ocultar Capa", 62);
+    glutAddMenuEntry("Subir Capa", 63);
+    glutAddMenuEntry("Bajar Capa", 64);
+    glutAddMenuEntry("Listar Capas", 65);
+    glutAddMenuEntry("Renombrar Capa", 66);
 
     int helpMenu = glutCreateMenu(menu);
     glutAddMenuEntry("Atajos de Teclado", 50);
@@ -555,11 +1827,21 @@ void createMenu() {
     glutAddSubMenu("Grosor", thicknessMenu);
     glutAddSubMenu("Vista", viewMenu);
     glutAddSubMenu("Herramientas", toolsMenu);
+    glutAddSubMenu("Capas", layerMenu);
     glutAddSubMenu("Ayuda", helpMenu);
 
     glutAttachMenu(GLUT_RIGHT_BUTTON);
 }
 
+// Las cachs, el scissor y la conversin de coordenadas del ratn asumen una
+// ventana de WINDOW_WIDTH x WINDOW_HEIGHT, por lo que se mantiene ese tamao
+void reshape(int width, int height) {
+    if (width != WINDOW_WIDTH || height != WINDOW_HEIGHT) {
+        glutReshapeWindow(WINDOW_WIDTH, WINDOW_HEIGHT);
+    }
+    glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+}
+
 void init() {
     glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
     glMatrixMode(GL_PROJECTION);
@@ -570,21 +1852,34 @@ void init() {
 
 int main(int argc, char** argv) {
     glutInit(&argc, argv);
-    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB);
+    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGBA | GLUT_ALPHA); // alfa para las cachs de capa
+    if (!glutGet(GLUT_DISPLAY_MODE_POSSIBLE)) glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB);
     glutInitWindowSize(WINDOW_WIDTH, WINDOW_HEIGHT);
     glutInitWindowPosition(100, 100);
     glutCreateWindow("Software CAD 2D Bsico");
+    destinationAlpha = glutGet(GLUT_WINDOW_ALPHA_SIZE) > 0;
 
     init();
+    gpuAvailable = initGPURenderer();
+    addLayer();
+
+    // Comparacin CPU vs GPU sin interaccin, p. ej. con Mesa llvmpipe:
+    // LIBGL_ALWAYS_SOFTWARE=1 xvfb-run ./programa --compare
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "--compare") return runRendererTest();
+    }
+
     createMenu();
 
     glutDisplayFunc(display);
+    glutReshapeFunc(reshape);
     glutMouseFunc(mouse);
+    glutMotionFunc(motion);
     glutKeyboardFunc(keyboard);
 
     cout << "Software CAD 2D Bsico" << endl;
     cout << "Use el botn derecho para acceder al men" << endl;
-    cout << "Atajos: G (cuadrcula), E (ejes), C (limpiar), S (exportar), Z (deshacer), Y (rehacer)" << endl;
+    cout << "Atajos: G (cuadrcula), E (ejes), C (limpiar), S (exportar), Z (deshacer), Y (rehacer), R (CPU/GPU), +/- [ ] (escalar/rotar seleccin), N/L/H (capas)" << endl;
 
     glutMainLoop();
     return 0;